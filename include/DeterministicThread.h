@@ -16,6 +16,12 @@
 #include <mutex>
 #include <condition_variable>
 #include <tuple>
+#include <array>
+#include <cstddef>
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <functional>
 
 namespace DeterministicConcurrency{
     /**
@@ -30,8 +36,30 @@ namespace DeterministicConcurrency{
         WAITING_EXTERNAL
     };
 
+    class thread_context;
+
     class DeterministicThread;
 
+    /**
+     * @brief The in-process transport of the UserControlledScheduler: threads stepped through condition variables.
+     */
+    struct ThreadTransport {
+        using context_type = thread_context;
+        using worker_type = DeterministicThread;
+        template<size_t N>
+        using storage_type = std::array<thread_context, N>;
+    };
+
+    template<size_t N, typename Transport = ThreadTransport>
+    class UserControlledScheduler;
+
+    /**
+     * @brief Identify the switch point at \p line of \p file, it is part of the program position hashed by the scheduler.
+     */
+    inline size_t switch_site(const char* file, unsigned line){
+        return std::hash<std::string_view>{}(file) * 31 + line;
+    }
+
     /**
      * @brief Provide the thread with basic functionalities.
      * 
@@ -62,11 +90,16 @@ namespace DeterministicConcurrency{
      */
     class thread_context {
     public:
-        thread_context() noexcept : control_mutex(), tick_tock(), thread_status_v(thread_status_t::NOT_STARTED) {}
+        thread_context() noexcept : control_mutex(), tick_tock(), thread_status_v(thread_status_t::NOT_STARTED), sync_armed(false), sync_reached(false), switch_site_v(0) {}
 
         /**
          * @brief Notify the scheduler that this thread is ready to give it back the control and wait until the scheduler notify back.
          * 
+         * @param file : the file of the caller, defaulted to the call site.
+         * @param line : the line of the caller, defaulted to the call site.
+         * 
+         * The call site identifies where the thread is stopped when the scheduler hashes its state.
+         * 
          * Example of `switchContext()`:
          * \code{.cpp}
          * void my_function(DeterministicConcurrency::thread_context* c) {
@@ -76,11 +109,42 @@ namespace DeterministicConcurrency{
          * };
          * \endcode
          */
-        void switchContext(){
-            tock();             
+        void switchContext(const char* file = __builtin_FILE(), unsigned line = __builtin_LINE()){
+            tock(switch_site(file, line));
             wait_for_tick();    
         }
 
+        /**
+         * @brief A labelled checkpoint: switch context back to the scheduler only if the scheduler is running this thread until \p label.
+         * 
+         * @param label : the name of this sync point, it must not be built from a null pointer.
+         * @param file : the file of the caller, defaulted to the call site.
+         * @param line : the line of the caller, defaulted to the call site.
+         * 
+         * Sync points that are not armed by `runUntil()` or `runUntilAny()` are skipped without any handshake with the scheduler,
+         * so they can be left in production code paths at little cost.
+         * 
+         * Example of `syncPoint()`:
+         * \code{.cpp}
+         * void my_function(DeterministicConcurrency::thread_context* c) {
+         *     //...do something
+         *     c->syncPoint("after_commit");
+         *     //...do something
+         * };
+         * \endcode
+         */
+        void syncPoint(std::string_view label, const char* file = __builtin_FILE(), unsigned line = __builtin_LINE()){
+            if (!sync_armed.load(std::memory_order_acquire))
+                return;
+            {
+                std::lock_guard<std::mutex> lock(control_mutex);
+                if (sync_label != label)
+                    return;
+                sync_reached = true;
+            }
+            switchContext(file, line);
+        }
+
         /**
          * @brief Lock \p lockable and update the current \p thread_status_v of the current `deterministic thread`.
          * 
@@ -165,8 +229,9 @@ namespace DeterministicConcurrency{
 
         /// @brief 
         /// @tparam N 
+        /// @tparam Transport 
         /// @private
-        template<size_t N>
+        template<size_t N, typename Transport>
         friend class UserControlledScheduler;
 
         /**
@@ -185,17 +250,21 @@ namespace DeterministicConcurrency{
             {
                 std::unique_lock<std::mutex> lock(control_mutex);
                 thread_status_v = thread_status_t::FINISHED;
+                switch_site_v = 0;
             }
             tick_tock.notify_one();
         }
         
         /**
          * @brief Allow the scheduler to proceed its execution.
+         * 
+         * @param site : the switch point this thread is stopped at.
          */
-        void tock() {
+        void tock(size_t site) {
             {
                 std::unique_lock<std::mutex> lock(control_mutex);
                 thread_status_v = thread_status_t::WAITING;
+                switch_site_v = site;
             }
             tick_tock.notify_one();
         }
@@ -209,9 +278,70 @@ namespace DeterministicConcurrency{
                 tick_tock.wait(lock);
         }
 
+        /**
+         * @brief Make syncPoint(label) stop this thread until disarm_sync_point() is called.
+         */
+        void arm_sync_point(std::string_view label){
+            std::lock_guard<std::mutex> lock(control_mutex);
+            sync_label = label;
+            sync_reached = false;
+            sync_armed.store(true, std::memory_order_release);
+        }
+
+        /**
+         * @brief Make every syncPoint() of this thread a no-op again.
+         */
+        void disarm_sync_point(){
+            std::lock_guard<std::mutex> lock(control_mutex);
+            sync_armed.store(false, std::memory_order_release);
+            sync_label.clear();
+        }
+
+        /**
+         * @brief Get the current status of this thread.
+         */
+        thread_status_t get_status() const {
+            return thread_status_v;
+        }
+
+        /**
+         * @brief Check whether any sync point of this thread is armed.
+         */
+        bool sync_point_armed() const {
+            return sync_armed.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief Check whether this thread is armed on the sync point labelled \p label.
+         */
+        bool sync_point_armed_on(std::string_view label){
+            std::lock_guard<std::mutex> lock(control_mutex);
+            return sync_armed.load(std::memory_order_relaxed) && sync_label == label;
+        }
+
+        /**
+         * @brief Check whether this thread is stopped at the armed sync point.
+         */
+        bool sync_point_reached(){
+            std::lock_guard<std::mutex> lock(control_mutex);
+            return sync_reached;
+        }
+
+        /**
+         * @brief Get the switch point this thread last stopped at, used as its program position.
+         */
+        size_t get_switch_site(){
+            std::lock_guard<std::mutex> lock(control_mutex);
+            return switch_site_v;
+        }
+
         std::condition_variable tick_tock;
         volatile thread_status_t thread_status_v;
         std::mutex control_mutex;
+        std::atomic<bool> sync_armed;
+        bool sync_reached;
+        std::string sync_label;
+        size_t switch_site_v;
     };
 
     /**
@@ -248,6 +378,13 @@ namespace DeterministicConcurrency{
             _this_thread->tick_tock.notify_one();
         }
 
+        /**
+         * @brief Get the status of the thread
+         */
+        thread_status_t poll_status(){
+            return _this_thread->get_status();
+        }
+
         /**
          * @brief Wait until the thread notify the scheduler
          */
@@ -0,0 +1,528 @@
+/**
+ * @file SharedMemoryScheduler.h
+ * @author F. Abrignani (federignoli@hotmail.it)
+ * @author P. Di Giglio
+ * @author S. Martorana
+ * @brief Contains the definition of shared_thread_context, DeterministicProcess and the ProcessTransport of the UserControlledScheduler
+ * @version 1.4.5
+ * @date 2023-08-14
+ * 
+ * @copyright Copyright (c) 2023
+ * 
+ */
+#pragma once
+#if defined(__linux__)
+#include <DeterministicConcurrency>
+#include <cstddef>
+#include <cstdint>
+#include <cerrno>
+#include <cstring>
+#include <array>
+#include <atomic>
+#include <tuple>
+#include <new>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <csignal>
+#include <ctime>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <unistd.h>
+
+namespace DeterministicConcurrency{
+
+    class shared_thread_context;
+
+    class DeterministicProcess;
+
+    template<size_t N>
+    class SharedContextSegment;
+
+    /**
+     * @brief The cross-process transport of the UserControlledScheduler: forked processes stepped through futexes in a shared memory segment.
+     */
+    struct ProcessTransport {
+        using context_type = shared_thread_context;
+        using worker_type = DeterministicProcess;
+        template<size_t N>
+        using storage_type = SharedContextSegment<N>;
+    };
+
+    /**
+     * @brief The process counterpart of thread_context: the handshake with the scheduler is a futex living in a shared memory segment.
+     * 
+     * Use case of `shared_thread_context`:
+     * \code{.cpp}
+     * void my_function(DeterministicConcurrency::shared_thread_context* c, RingBuffer* shared_ring) {
+     *     //...do something
+     *     c->switchContext();
+     *     //...do something
+     * };
+     * \endcode
+     */
+    class shared_thread_context {
+    public:
+        shared_thread_context() noexcept
+            : thread_status_v(static_cast<uint32_t>(thread_status_t::NOT_STARTED))
+            , switch_site_v(0)
+            , sync_lock(false)
+            , sync_armed(false)
+            , sync_reached(false)
+            , sync_label_size(0)
+            , sync_label()
+            , failed_v(false) {}
+
+        shared_thread_context(const shared_thread_context&) = delete;
+        shared_thread_context& operator=(const shared_thread_context&) = delete;
+
+        /**
+         * @brief The longest label a syncPoint() of a process can be armed on.
+         */
+        static constexpr size_t max_label_size = 64;
+
+        /**
+         * @brief Notify the scheduler that this process is ready to give it back the control and wait until the scheduler notify back.
+         * 
+         * @param file : the file of the caller, defaulted to the call site.
+         * @param line : the line of the caller, defaulted to the call site.
+         * 
+         * Example of `switchContext()`:
+         * \code{.cpp}
+         * void my_function(DeterministicConcurrency::shared_thread_context* c) {
+         *     //...do something
+         *     c->switchContext();
+         *     //...do something
+         * };
+         * \endcode
+         */
+        void switchContext(const char* file = __builtin_FILE(), unsigned line = __builtin_LINE()){
+            tock(switch_site(file, line));
+            wait_for_tick();
+        }
+
+        /**
+         * @brief A labelled checkpoint: switch context back to the scheduler only if the scheduler is running this process until \p label.
+         * 
+         * @param label : the name of this sync point, it must not be built from a null pointer.
+         * @param file : the file of the caller, defaulted to the call site.
+         * @param line : the line of the caller, defaulted to the call site.
+         */
+        void syncPoint(std::string_view label, const char* file = __builtin_FILE(), unsigned line = __builtin_LINE()){
+            if (!sync_armed.load(std::memory_order_acquire))
+                return;
+            {
+                sync_guard guard(sync_lock);
+                if (std::string_view(sync_label, sync_label_size) != label)
+                    return;
+                sync_reached = true;
+            }
+            switchContext(file, line);
+        }
+
+        /**
+         * @brief Lock \p lockable and update the current \p thread_status_v of the current `deterministic process`.
+         * 
+         * @param lockable : a lockable object shared between processes, like a process-shared mutex.
+         * @param args : arguments that will be forwarded to the .lock().
+         */
+        template<typename BasicLockable, typename... Args>
+        void lock(BasicLockable* lockable, Args&&... args){
+            set_status(thread_status_t::WAITING_EXTERNAL);
+            lockable->lock(std::forward<Args>(args)...);
+            set_status(thread_status_t::RUNNING);
+        }
+
+        /**
+         * @brief Lock \p lockable in shared mode and update the current \p thread_status_v of the current `deterministic process`.
+         * 
+         * @param lockable : a lockable object shared between processes.
+         * @param args : arguments that will be forwarded to the .lock_shared().
+         */
+        template<typename BasicLockable, typename... Args>
+        void lock_shared(BasicLockable* lockable, Args&&... args){
+            set_status(thread_status_t::WAITING_EXTERNAL);
+            lockable->lock_shared(std::forward<Args>(args)...);
+            set_status(thread_status_t::RUNNING);
+        }
+
+        private:
+
+        /// @brief 
+        /// @private
+        friend class DeterministicProcess;
+
+        /// @brief 
+        /// @tparam N 
+        /// @tparam Transport 
+        /// @private
+        template<size_t N, typename Transport>
+        friend class UserControlledScheduler;
+
+        static_assert(std::atomic<uint32_t>::is_always_lock_free && sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+                      "the futex word must be a plain lock free 32 bit integer");
+        static_assert(std::atomic<bool>::is_always_lock_free && std::atomic<size_t>::is_always_lock_free,
+                      "atomics shared between processes must be lock free");
+
+        /**
+         * @brief A spinlock guarding the sync point fields, a std::mutex cannot be shared between processes.
+         */
+        struct sync_guard {
+            explicit sync_guard(std::atomic<bool>& lock) : _lock(lock) {
+                while (_lock.exchange(true, std::memory_order_acquire))
+                    std::this_thread::yield();
+            }
+            ~sync_guard() {
+                _lock.store(false, std::memory_order_release);
+            }
+            std::atomic<bool>& _lock;
+        };
+
+        /**
+         * @brief Wait until the scheduler switch context to this process.
+         */
+        void start(){
+            while (get_status() == thread_status_t::NOT_STARTED)
+                futex_wait(thread_status_t::NOT_STARTED, nullptr);
+        }
+
+        /**
+         * @brief Notify the scheduler that this process has finished not allowing the scheduler anymore to switch context to this process.
+         */
+        void finish(){
+            switch_site_v.store(0, std::memory_order_relaxed);
+            set_status(thread_status_t::FINISHED);
+            futex_wake();
+        }
+
+        /**
+         * @brief Notify the scheduler that the function of this process threw.
+         */
+        void fail(){
+            failed_v.store(true, std::memory_order_release);
+            finish();
+        }
+
+        bool failed() const {
+            return failed_v.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief Allow the scheduler to proceed its execution.
+         * 
+         * @param site : the switch point this process is stopped at.
+         */
+        void tock(size_t site){
+            switch_site_v.store(site, std::memory_order_relaxed);
+            set_status(thread_status_t::WAITING);
+            futex_wake();
+        }
+
+        /**
+         * @brief Wait until the scheduler notify this process.
+         */
+        void wait_for_tick(){
+            while (get_status() == thread_status_t::WAITING)
+                futex_wait(thread_status_t::WAITING, nullptr);
+        }
+
+        /**
+         * @brief Allow the process to proceed its execution.
+         */
+        void tick(){
+            auto expected = thread_status_v.load(std::memory_order_acquire);
+            do {
+                if (expected != static_cast<uint32_t>(thread_status_t::WAITING) &&
+                    expected != static_cast<uint32_t>(thread_status_t::NOT_STARTED))
+                    return;
+            } while (!thread_status_v.compare_exchange_weak(expected, static_cast<uint32_t>(thread_status_t::RUNNING),
+                                                            std::memory_order_acq_rel));
+            futex_wake();
+        }
+
+        thread_status_t get_status() const {
+            return static_cast<thread_status_t>(thread_status_v.load(std::memory_order_acquire));
+        }
+
+        void set_status(thread_status_t status){
+            thread_status_v.store(static_cast<uint32_t>(status), std::memory_order_release);
+        }
+
+        size_t get_switch_site() const {
+            return switch_site_v.load(std::memory_order_relaxed);
+        }
+
+        void arm_sync_point(std::string_view label){
+            if (label.size() > max_label_size)
+                throw std::length_error("sync point label longer than shared_thread_context::max_label_size");
+            sync_guard guard(sync_lock);
+            std::memcpy(sync_label, label.data(), label.size());
+            sync_label_size = label.size();
+            sync_reached = false;
+            sync_armed.store(true, std::memory_order_release);
+        }
+
+        void disarm_sync_point(){
+            sync_guard guard(sync_lock);
+            sync_armed.store(false, std::memory_order_release);
+            sync_reached = false;
+            sync_label_size = 0;
+        }
+
+        bool sync_point_armed() const {
+            return sync_armed.load(std::memory_order_acquire);
+        }
+
+        bool sync_point_armed_on(std::string_view label){
+            sync_guard guard(sync_lock);
+            return sync_armed.load(std::memory_order_relaxed) && std::string_view(sync_label, sync_label_size) == label;
+        }
+
+        bool sync_point_reached(){
+            sync_guard guard(sync_lock);
+            return sync_reached;
+        }
+
+        /**
+         * @brief Sleep while the status is \p status or until \p timeout expires; the futex is not private since the word is shared between processes.
+         */
+        void futex_wait(thread_status_t status, const timespec* timeout){
+            syscall(SYS_futex, reinterpret_cast<uint32_t*>(&thread_status_v), FUTEX_WAIT,
+                    static_cast<uint32_t>(status), timeout, nullptr, 0);
+        }
+
+        void futex_wake(){
+            syscall(SYS_futex, reinterpret_cast<uint32_t*>(&thread_status_v), FUTEX_WAKE,
+                    1, nullptr, nullptr, 0);
+        }
+
+        std::atomic<uint32_t> thread_status_v;
+        std::atomic<size_t> switch_site_v;
+        std::atomic<bool> sync_lock;
+        std::atomic<bool> sync_armed;
+        bool sync_reached;
+        size_t sync_label_size;
+        char sync_label[max_label_size];
+        std::atomic<bool> failed_v;
+    };
+
+    /**
+     * @brief The contexts of a UserControlledScheduler<N, ProcessTransport>, placed in an anonymous shared memory segment.
+     * 
+     * @tparam N 
+     */
+    template<size_t N>
+    class SharedContextSegment {
+    public:
+        SharedContextSegment() : _contexts(map_contexts()) {}
+
+        SharedContextSegment(const SharedContextSegment&) = delete;
+        SharedContextSegment& operator=(const SharedContextSegment&) = delete;
+
+        ~SharedContextSegment(){
+            _contexts->~array();
+            ::munmap(_contexts, sizeof(std::array<shared_thread_context, N>));
+        }
+
+        shared_thread_context& operator[](size_t index){
+            return (*_contexts)[index];
+        }
+
+        auto begin(){
+            return _contexts->begin();
+        }
+
+        auto end(){
+            return _contexts->end();
+        }
+
+    private:
+        static std::array<shared_thread_context, N>* map_contexts(){
+            void* segment = ::mmap(nullptr, sizeof(std::array<shared_thread_context, N>), PROT_READ | PROT_WRITE,
+                                   MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+            if (segment == MAP_FAILED)
+                throw std::system_error(errno, std::generic_category(), "mmap");
+            return new (segment) std::array<shared_thread_context, N>;
+        }
+
+        std::array<shared_thread_context, N>* _contexts;
+    };
+
+    /**
+     * @brief A forked process controlled by the UserControlledScheduler
+     * 
+     * The process is forked by the constructor, so if other threads exist at that point the child must only rely on
+     * async-signal-safe code until it is scheduled: locks held by those threads are never released in the child.
+     * The process is killed when the thread which created it dies, even if it crashes, and a process destroyed before
+     * being joined is killed and reaped.
+     * 
+     * A process that dies while being scheduled, or whose function throws, is marked as FINISHED and the next
+     * poll_status(), wait_for_tock() or join() throws a std::runtime_error describing how it ended.
+     */
+    class DeterministicProcess {
+    public:
+        /// @private
+        template <typename Func, typename... Args>
+        explicit DeterministicProcess(shared_thread_context* t, Func&& func, Args&&... args)
+            : _this_process(t), _pid(fork_participant()), _failure_reported(false) {
+            if (_pid != 0)
+                return;
+            // the child never returns from here, not even by throwing
+            try {
+                t->start();
+                std::apply(std::forward<Func>(func), std::tuple_cat(std::make_tuple(t), std::forward_as_tuple(std::forward<Args>(args)...)));
+                t->finish();
+            }
+            catch (...) {
+                t->fail();
+                ::_exit(1);
+            }
+            ::_exit(0);
+        }
+
+        DeterministicProcess(const DeterministicProcess&) = delete;
+        DeterministicProcess& operator=(const DeterministicProcess&) = delete;
+
+        ~DeterministicProcess(){
+            if (_pid <= 0)
+                return;
+            ::kill(_pid, SIGKILL);
+            while (::waitpid(_pid, nullptr, 0) == -1 && errno == EINTR);
+        }
+
+        /**
+         * @brief Wait for this process to exit
+         */
+        void join() {
+            if (_pid <= 0){
+                report_failure();
+                return;
+            }
+            int wait_status;
+            while (::waitpid(_pid, &wait_status, 0) == -1 && errno == EINTR);
+            _pid = 0;
+            check_exit(wait_status);
+        }
+
+        /**
+         * @brief Allow the process to proceed its execution
+         */
+        void tick() {
+            _this_process->tick();
+        }
+
+        /**
+         * @brief Wait until the process notify the scheduler
+         */
+        void wait_for_tock(){
+            const timespec timeout{0, 10 * 1000 * 1000};
+            while (poll_status() == thread_status_t::RUNNING)
+                _this_process->futex_wait(thread_status_t::RUNNING, &timeout);
+        }
+
+        /**
+         * @brief Get the status of the process, reaping it if it is dead.
+         */
+        thread_status_t poll_status(){
+            auto status = _this_process->get_status();
+            if (status == thread_status_t::FINISHED){
+                report_failure();
+                return status;
+            }
+            if (_pid <= 0)
+                return status;
+            int wait_status;
+            pid_t res = ::waitpid(_pid, &wait_status, WNOHANG);
+            if (res == 0 || (res == -1 && errno == EINTR))
+                return status;
+            _pid = 0;
+            check_exit(wait_status);
+            return thread_status_t::FINISHED;
+        }
+
+    private:
+        /**
+         * @brief Fork a participant which dies together with the thread forking it.
+         */
+        static pid_t fork_participant(){
+            pid_t parent = ::getpid();
+            pid_t pid = ::fork();
+            if (pid == -1)
+                throw std::system_error(errno, std::generic_category(), "fork");
+            // the parent may have died before prctl, in which case the child is already orphaned
+            if (pid == 0 && (::prctl(PR_SET_PDEATHSIG, SIGKILL) == -1 || ::getppid() != parent))
+                ::_exit(1);
+            return pid;
+        }
+
+        /**
+         * @brief Mark the reaped process as FINISHED and throw if it did not end normally.
+         */
+        void check_exit(int wait_status){
+            bool finished = _this_process->get_status() == thread_status_t::FINISHED;
+            _this_process->set_status(thread_status_t::FINISHED);
+            if (_failure_reported || _this_process->failed())
+                return report_failure();
+            if (WIFSIGNALED(wait_status))
+                return throw_failure("deterministic process killed by signal " + std::to_string(WTERMSIG(wait_status)));
+            if (!finished)
+                return throw_failure("deterministic process exited while running");
+            if (WIFEXITED(wait_status) && WEXITSTATUS(wait_status) != 0)
+                return throw_failure("deterministic process exited with status " + std::to_string(WEXITSTATUS(wait_status)));
+        }
+
+        /**
+         * @brief Throw if the function of the process threw and it has not been reported yet.
+         */
+        void report_failure(){
+            if (!_failure_reported && _this_process->failed())
+                throw_failure("the function of a deterministic process threw an exception");
+        }
+
+        void throw_failure(const std::string& what){
+            _failure_reported = true;
+            throw std::runtime_error(what);
+        }
+
+        shared_thread_context* _this_process;
+        pid_t _pid;
+        bool _failure_reported;
+    };
+
+    /**
+     * @brief A UserControlledScheduler whose workers are forked processes.
+     * 
+     * Data shared by the processes must be mapped with MAP_SHARED before the scheduler is constructed.
+     * 
+     * @tparam N 
+     */
+    template<size_t N>
+    using SharedMemoryScheduler = UserControlledScheduler<N, ProcessTransport>;
+
+    /**
+     * @brief Helper function to create a SharedMemoryScheduler
+     * 
+     * @param tuples : tuples containing the function the processes have to performs followed by their arguments.
+     * @return SharedMemoryScheduler 
+     * 
+     * example of `make_SharedMemoryScheduler()`:
+     * \code{.cpp}
+     * void f(shared_thread_context* c, int* shared){}
+     * auto process0 = tuple{&f, shared};
+     * auto process1 = tuple{&f, shared};
+     * auto sch = make_SharedMemoryScheduler(process0, process1);
+     * \endcode
+     */
+    template<typename... Tuples>
+    auto make_SharedMemoryScheduler(Tuples&&... tuples) {
+        return SharedMemoryScheduler<sizeof...(Tuples)>(static_cast<Tuples&&>(tuples)...);
+    }
+
+}
+#endif
@@ -18,6 +18,9 @@
 #include <type_traits>
 #include <chrono>
 #include <thread>
+#include <initializer_list>
+#include <functional>
+#include <string_view>
 
 namespace DeterministicConcurrency{
 
@@ -25,11 +28,13 @@ namespace DeterministicConcurrency{
      * @brief A scheduler which allow to manage the flow of its managed threads.
      * 
      * @tparam N 
+     * @tparam Transport : how the scheduler talks to its workers, ThreadTransport for threads of this process.
      */
-    template<size_t N>
+    template<size_t N, typename Transport>
     class UserControlledScheduler{
 
-        struct emplace_t {};
+        using context_type = typename Transport::context_type;
+        using worker_type = typename Transport::worker_type;
 
         public:
 
@@ -126,6 +131,80 @@ namespace DeterministicConcurrency{
             }(),...);
         }
 
+        /**
+         * @brief Let the thread with threadIndex run until it reaches the syncPoint labelled label or finishes.
+         * 
+         * Plain switchContext() calls met along the way are stepped over.
+         * 
+         * @param threadIndex : Index of the thread to perform runUntil on
+         * @param label : the label of the syncPoint the thread has to stop at
+         * @return true if the thread is stopped at label, false if it finished without reaching it.
+         * 
+         * example:
+         * \code{.cpp}
+         * sch.runUntil(0, "after_commit");
+         * \endcode
+         */
+        bool runUntil(size_t threadIndex, std::string_view label){
+            _contexts[threadIndex].arm_sync_point(label);
+            do {
+                proceed(threadIndex);
+                wait(threadIndex);
+            } while (getThreadStatus(threadIndex) != thread_status_t::FINISHED && !_contexts[threadIndex].sync_point_reached());
+            bool reached = _contexts[threadIndex].sync_point_reached();
+            _contexts[threadIndex].disarm_sync_point();
+            return reached;
+        }
+
+        /**
+         * @brief Let the threads with threadIndixes run until one of them reaches the syncPoint labelled label and return its index.
+         * 
+         * The other threads keep running and stay armed on label, they can be collected with wait() or another runUntilAny().
+         * A thread still armed on a different label by a previous runUntilAny() is re-armed on label, and resumed if it is stopped at the old one.
+         * 
+         * @param threadIndixes : Indixes of the threads to perform runUntilAny on
+         * @param label : the label of the syncPoint the threads have to stop at
+         * @return size_t : the index of the first thread who reached label, or -1 if all of them finished without reaching it.
+         * 
+         * example:
+         * \code{.cpp}
+         * auto index = sch.runUntilAny({0, 1, 2}, "after_commit");
+         * \endcode
+         */
+        size_t runUntilAny(std::initializer_list<size_t> threadIndixes, std::string_view label){
+            for (auto threadIndex : threadIndixes){
+                if (!_contexts[threadIndex].sync_point_armed()){
+                    _contexts[threadIndex].arm_sync_point(label);
+                    proceed(threadIndex);
+                }
+                else if (!_contexts[threadIndex].sync_point_armed_on(label))
+                    _contexts[threadIndex].arm_sync_point(label); // if stopped at the old label it is resumed below
+            }
+            for (;;){
+                size_t numFinished = 0;
+                for (auto threadIndex : threadIndixes){
+                    auto status = getThreadStatus(threadIndex);
+                    if (status == thread_status_t::FINISHED){
+                        numFinished++;
+                        continue;
+                    }
+                    if (status != thread_status_t::WAITING)
+                        continue;
+                    if (_contexts[threadIndex].sync_point_reached()){
+                        _contexts[threadIndex].disarm_sync_point();
+                        return threadIndex;
+                    }
+                    proceed(threadIndex);
+                }
+                if (numFinished == threadIndixes.size()){
+                    for (auto threadIndex : threadIndixes)
+                        _contexts[threadIndex].disarm_sync_point();
+                    return -1;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+
         /**
          * @brief Switch context allowing all the threads to proceed while stopping the scheduler from executing until all of the threads switchContext back.
          * 
@@ -204,22 +283,67 @@ namespace DeterministicConcurrency{
          * 
          * @param threadIndex Obtain the thread_status of the thread identified by threadIndex.
          * @return thread_status_t : the status of the threadIndex-th thread.
+         * 
+         * With the ProcessTransport a dead process is reaped here, so every API polling the status throws if it did not end normally.
          */
         thread_status_t getThreadStatus(size_t threadIndex){
-            return _contexts[threadIndex].thread_status_v;
+            return _threads[threadIndex].poll_status();
         }
 
-        private:
+        /**
+         * @brief Register a cheap hash of the shared data the threads operate on.
+         * 
+         * @param stateHash : a callable returning a size_t hash of the shared data.
+         * 
+         * example:
+         * \code{.cpp}
+         * sch.setStateHash([&]{ return std::hash<int>{}(counter); });
+         * \endcode
+         */
+        template<typename Func>
+        void setStateHash(Func&& stateHash){
+            _state_hash = std::forward<Func>(stateHash);
+        }
 
-        template <typename... Tuples>
-        UserControlledScheduler(emplace_t, Tuples&&... tuples)
-            : _threads{std::make_from_tuple<DeterministicThread>(tuples)...} {}
+        /**
+         * @brief Get the hash of the current state: the registered state hash combined with the status and the switch point every thread is stopped at.
+         * 
+         * @return size_t : the hash of the current state.
+         */
+        size_t stateHash(){
+            size_t seed = _state_hash ? _state_hash() : 0;
+            for (auto& context : _contexts){
+                hash_combine(seed, static_cast<size_t>(context.get_status()));
+                hash_combine(seed, context.get_switch_site());
+            }
+            return seed;
+        }
 
+        /**
+         * @brief Record the current state in visited.
+         * 
+         * @param visited : the set of states already explored.
+         * @return true if the current state is new, false if the current schedule can be cut off.
+         * 
+         * example:
+         * \code{.cpp}
+         * sch.switchContextTo(0);
+         * if (!sch.visitState(visited))
+         *     return;
+         * \endcode
+         */
+        bool visitState(VisitedStateSet& visited){
+            return visited.insert(stateHash());
+        }
+
+        private:
+
+        // _contexts is initialized before _threads, so the workers can be handed the address of their context
         template <typename... Tuples, std::size_t... Is>
         UserControlledScheduler(std::index_sequence<Is...>, Tuples&&... tuples)
-            : UserControlledScheduler{
-                emplace_t{}, std::tuple_cat(std::tuple{&std::get<Is>(_contexts)},
-                                            static_cast<Tuples&&>(tuples))...} {}
+            : _contexts{}
+            , _threads{std::make_from_tuple<worker_type>(
+                std::tuple_cat(std::tuple{&_contexts[Is]}, static_cast<Tuples&&>(tuples)))...} {}
 
 
         template <std::size_t... Is>
@@ -230,8 +354,13 @@ namespace DeterministicConcurrency{
             }(),...);
         }
 
-        std::array<thread_context, N> _contexts;
-        std::array<DeterministicThread, N> _threads;
+        static void hash_combine(size_t& seed, size_t value){
+            seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        }
+
+        typename Transport::template storage_type<N> _contexts;
+        std::array<worker_type, N> _threads;
+        std::function<size_t()> _state_hash;
     };
 
     /**
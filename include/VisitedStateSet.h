@@ -0,0 +1,77 @@
+/**
+ * @file VisitedStateSet.h
+ * @author F. Abrignani (federignoli@hotmail.it)
+ * @author P. Di Giglio
+ * @author S. Martorana
+ * @brief Contains the definition of VisitedStateSet
+ * @version 1.4.5
+ * @date 2023-08-14
+ * 
+ * @copyright Copyright (c) 2023
+ * 
+ */
+#pragma once
+#include <cstddef>
+#include <mutex>
+#include <unordered_set>
+
+namespace DeterministicConcurrency{
+
+    /**
+     * @brief A thread safe set of state hashes, shared by the schedulers exploring the same scenario.
+     * 
+     * Use case of `VisitedStateSet`:
+     * \code{.cpp}
+     * static DeterministicConcurrency::VisitedStateSet visited;
+     * 
+     * sch.switchContextTo(0);
+     * if (!sch.visitState(visited))
+     *     return; // this schedule reached a state already explored
+     * \endcode
+     */
+    class VisitedStateSet {
+    public:
+        VisitedStateSet() : _states(), _states_mutex() {}
+
+        /**
+         * @brief Insert \p stateHash in the set.
+         * 
+         * @param stateHash : the hash of the state to insert.
+         * @return true if \p stateHash was not visited before, false otherwise.
+         */
+        bool insert(size_t stateHash){
+            std::lock_guard<std::mutex> lock(_states_mutex);
+            return _states.insert(stateHash).second;
+        }
+
+        /**
+         * @brief Check whether \p stateHash has already been visited.
+         * 
+         * @param stateHash : the hash of the state to look for.
+         */
+        bool contains(size_t stateHash){
+            std::lock_guard<std::mutex> lock(_states_mutex);
+            return _states.count(stateHash) != 0;
+        }
+
+        /**
+         * @brief Get the number of visited states.
+         */
+        size_t size(){
+            std::lock_guard<std::mutex> lock(_states_mutex);
+            return _states.size();
+        }
+
+        /**
+         * @brief Forget every visited state.
+         */
+        void clear(){
+            std::lock_guard<std::mutex> lock(_states_mutex);
+            _states.clear();
+        }
+
+    private:
+        std::unordered_set<size_t> _states;
+        std::mutex _states_mutex;
+    };
+}
@@ -0,0 +1,50 @@
+#include <DeterministicConcurrency>
+#include <vector>
+
+namespace scenario3DS{
+
+    static std::vector<int> ret;
+
+    static std::vector<bool> reached;
+
+    static std::vector<size_t> winners;
+
+    void threadFunc(DeterministicConcurrency::thread_context* t, int arg) {
+        t->syncPoint("before_push");
+        ret.push_back(arg);
+        t->switchContext();
+        t->syncPoint("after_push");
+        ret.push_back(arg + 10);
+        t->syncPoint("before_exit");
+    }
+
+    static DeterministicConcurrency::UserControlledScheduler<3> sch{
+        std::tuple{&threadFunc, 0}, //0
+        std::tuple{&threadFunc, 1}, //1
+        std::tuple{&threadFunc, 2}  //2
+    };
+
+    static std::vector<int> passed_a;
+
+    void threadFuncAB(DeterministicConcurrency::thread_context* t, int arg) {
+        t->syncPoint("A");
+        passed_a.push_back(arg);
+        t->syncPoint("B");
+    }
+
+    static DeterministicConcurrency::UserControlledScheduler<2> sch_ab{
+        std::tuple{&threadFuncAB, 0}, //0
+        std::tuple{&threadFuncAB, 1}  //1
+    };
+
+    static std::vector<bool> loser_passed_a;
+
+    static std::vector<int> expected{1,11,0,2,12,10};
+
+    static std::vector<bool> expected_reached{true,true,true,false};
+
+    static std::vector<size_t> expected_winners{2,size_t(-1)};
+
+    static std::vector<bool> expected_loser_passed_a{true};
+
+}
@@ -0,0 +1,63 @@
+#include <DeterministicConcurrency>
+#include <vector>
+
+namespace scenario4DS{
+
+    static DeterministicConcurrency::VisitedStateSet visited;
+
+    static int counter_a = 0;
+
+    static int counter_b = 0;
+
+    static std::vector<bool> visits;
+
+    void threadFunc(DeterministicConcurrency::thread_context* t, int* counter) {
+        (*counter)++;
+        t->switchContext();
+    }
+
+    static DeterministicConcurrency::UserControlledScheduler<2> sch_a{
+        std::tuple{&threadFunc, &counter_a}, //0
+        std::tuple{&threadFunc, &counter_a}  //1
+    };
+
+    static DeterministicConcurrency::UserControlledScheduler<2> sch_b{
+        std::tuple{&threadFunc, &counter_b}, //0
+        std::tuple{&threadFunc, &counter_b}  //1
+    };
+
+    static std::vector<bool> expected{true,true,true,false};
+    // 01 is explored first, 10 ends in the same state and is cut off
+
+    static DeterministicConcurrency::VisitedStateSet visited_sites;
+
+    static std::vector<bool> site_visits;
+
+    void branchFunc(DeterministicConcurrency::thread_context* t, bool empty) {
+        if (empty)
+            t->switchContext();
+        else
+            t->switchContext();
+    }
+
+    void loopFunc(DeterministicConcurrency::thread_context* t) {
+        for (int i = 0; i < 2; i++)
+            t->switchContext();
+    }
+
+    static DeterministicConcurrency::UserControlledScheduler<1> sch_c{
+        std::tuple{&branchFunc, true}
+    };
+
+    static DeterministicConcurrency::UserControlledScheduler<1> sch_d{
+        std::tuple{&branchFunc, false}
+    };
+
+    static DeterministicConcurrency::UserControlledScheduler<1> sch_e{
+        std::tuple{&loopFunc}
+    };
+
+    static std::vector<bool> expected_site_visits{true,true,true,false};
+    // the two branches stop after the same number of switches but at different sites,
+    // the second iteration of the loop stops at the same site as the first one
+}
@@ -0,0 +1,42 @@
+#include <DeterministicConcurrency>
+#include <sys/mman.h>
+#include <vector>
+
+namespace scenario5DS{
+
+    struct RingBuffer {
+        int data[8];
+        int tail;
+    };
+
+    static RingBuffer* ring = new (::mmap(nullptr, sizeof(RingBuffer), PROT_READ | PROT_WRITE,
+                                          MAP_SHARED | MAP_ANONYMOUS, -1, 0)) RingBuffer{};
+
+    void processFunc(DeterministicConcurrency::shared_thread_context* t, int arg1, int arg2) {
+        ring->data[ring->tail++ % 8] = arg1;
+
+        t->switchContext();
+
+        ring->data[ring->tail++ % 8] = arg2;
+    }
+
+    // the scheduler is built in main once every std::thread has been joined
+    static auto process0 = std::tuple{&processFunc, 0, 1};
+    static auto process1 = std::tuple{&processFunc, 2, 3};
+    static auto process2 = std::tuple{&processFunc, 4, 5};
+
+    static std::vector<int> expected{4,0,2,1,5,3};
+
+    static std::vector<DeterministicConcurrency::thread_status_t> expected_status{
+        DeterministicConcurrency::thread_status_t::WAITING,
+        DeterministicConcurrency::thread_status_t::FINISHED,
+        DeterministicConcurrency::thread_status_t::FINISHED
+    };
+
+    static std::vector<DeterministicConcurrency::thread_status_t> status;
+
+    static std::vector<int> ret() {
+        return std::vector<int>(ring->data, ring->data + ring->tail);
+    }
+
+}
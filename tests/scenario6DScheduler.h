@@ -0,0 +1,148 @@
+#include <DeterministicConcurrency>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <sys/prctl.h>
+#include <sys/resource.h>
+#include <cstdlib>
+#include <chrono>
+#include <thread>
+#include <csignal>
+#include <cerrno>
+#include <stdexcept>
+#include <vector>
+
+namespace scenario6DS{
+
+    using DeterministicConcurrency::thread_status_t;
+
+    struct SharedMutex {
+        SharedMutex() {
+            pthread_mutexattr_t attr;
+            pthread_mutexattr_init(&attr);
+            pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+            pthread_mutex_init(&m, &attr);
+            pthread_mutexattr_destroy(&attr);
+        }
+        void lock() { pthread_mutex_lock(&m); }
+        void unlock() { pthread_mutex_unlock(&m); }
+        bool try_lock() { return pthread_mutex_trylock(&m) == 0; }
+        pthread_mutex_t m;
+    };
+
+    struct SharedData {
+        SharedMutex mutex;
+        int data[8];
+        int tail;
+    };
+
+    static SharedData* shared = new (::mmap(nullptr, sizeof(SharedData), PROT_READ | PROT_WRITE,
+                                            MAP_SHARED | MAP_ANONYMOUS, -1, 0)) SharedData{};
+
+    void push(int arg) {
+        shared->data[shared->tail++ % 8] = arg;
+    }
+
+    void throwingFunc(DeterministicConcurrency::shared_thread_context* t) {
+        t->switchContext();
+        throw std::runtime_error("thrown in the child");
+    }
+
+    void killedFunc(DeterministicConcurrency::shared_thread_context* t) {
+        t->switchContext();
+        std::raise(SIGKILL);
+    }
+
+    void killedBeforeSyncPointFunc(DeterministicConcurrency::shared_thread_context* t) {
+        std::raise(SIGKILL);
+        t->syncPoint("x");
+    }
+
+    void neverJoinedFunc(DeterministicConcurrency::shared_thread_context* t, int arg) {
+        t->switchContext();
+        push(arg);
+    }
+
+    void lockingFunc(DeterministicConcurrency::shared_thread_context* t, int arg) {
+        t->lock(&shared->mutex);
+        t->switchContext();
+        push(arg);
+        shared->mutex.unlock();
+    }
+
+    void syncPointFunc(DeterministicConcurrency::shared_thread_context* t, int arg) {
+        t->syncPoint("before_push");
+        push(arg);
+        t->switchContext();
+        t->syncPoint("after_push");
+        push(arg + 10);
+    }
+
+    static std::vector<thread_status_t> status;
+
+    static std::vector<bool> thrown;
+
+    static std::vector<bool> reached;
+
+    static std::vector<thread_status_t> expected_status{
+        thread_status_t::FINISHED,          // the throwing process
+        thread_status_t::FINISHED,          // the killed process
+        thread_status_t::FINISHED,          // the process killed before its sync point
+        thread_status_t::WAITING_EXTERNAL   // process 1 blocked on the mutex owned by process 0
+    };
+
+    static std::vector<bool> expected_thrown{true, true, true};
+
+    static std::vector<bool> expected_reached{true, true};
+
+    static std::vector<int> expected{0, 1, 2, 12};
+    // 0 and 1 from the locking processes, 2 and 12 from the sync point process, nothing from the one never joined
+
+    static bool orphans_killed = false;
+
+    void orphanFunc(DeterministicConcurrency::shared_thread_context* t) {
+        t->switchContext();
+    }
+
+    /**
+     * A parent crashes after scheduling its first process once: neither the process waiting to be
+     * switched back to nor the one never started may outlive it.
+     */
+    static bool killParentOfScheduler() {
+        // orphans are reparented to this process, so it can reap them and see how they ended
+        prctl(PR_SET_CHILD_SUBREAPER, 1);
+        pid_t parent = ::fork();
+        if (parent == 0) {
+            rlimit no_core{0, 0};
+            setrlimit(RLIMIT_CORE, &no_core);
+            auto sch = DeterministicConcurrency::make_SharedMemoryScheduler(
+                std::tuple{&orphanFunc}, std::tuple{&orphanFunc});
+            sch.switchContextTo(0);
+            std::abort();
+        }
+        ::waitpid(parent, nullptr, 0);
+        // both processes must die on their own, give up after a couple of seconds instead of hanging
+        int killed = 0;
+        for (int attempt = 0; killed < 2 && attempt < 2000; attempt++) {
+            int status;
+            pid_t pid = ::waitpid(-1, &status, WNOHANG);
+            if (pid > 0 && WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL)
+                killed++;
+            else if (pid == 0)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            else
+                break;
+        }
+        prctl(PR_SET_CHILD_SUBREAPER, 0);
+        return killed == 2;
+    }
+
+    static std::vector<int> ret() {
+        return std::vector<int>(shared->data, shared->data + shared->tail);
+    }
+
+    static bool allChildrenReaped() {
+        return ::waitpid(-1, nullptr, WNOHANG) == -1 && errno == ECHILD;
+    }
+
+}
@@ -3,6 +3,10 @@
 #include <DeterministicConcurrency>
 #include "scenario1DScheduler.h"
 #include "scenario2DScheduler.h"
+#include "scenario3DScheduler.h"
+#include "scenario4DScheduler.h"
+#include "scenario5DScheduler.h"
+#include "scenario6DScheduler.h"
 
 
 TEST(UserCtrlSchedulerSimpleTest, Scenario1) {
@@ -16,6 +20,32 @@ TEST(UserCtrlScheduler2ParallelismTest, Scenario1) {
     EXPECT_EQ(scenario2DS::ret2_after, scenario2DS::expected2_after);
 }
 
+TEST(UserCtrlSchedulerSyncPointTest, Scenario1) {
+    EXPECT_EQ(scenario3DS::ret, scenario3DS::expected);
+    EXPECT_EQ(scenario3DS::reached, scenario3DS::expected_reached);
+    EXPECT_EQ(scenario3DS::winners, scenario3DS::expected_winners);
+    EXPECT_EQ(scenario3DS::loser_passed_a, scenario3DS::expected_loser_passed_a);
+}
+
+TEST(UserCtrlSchedulerStateHashTest, Scenario1) {
+    EXPECT_EQ(scenario4DS::visits, scenario4DS::expected);
+    EXPECT_EQ(scenario4DS::site_visits, scenario4DS::expected_site_visits);
+}
+
+TEST(SharedMemorySchedulerTest, Scenario1) {
+    EXPECT_EQ(scenario5DS::ret(), scenario5DS::expected);
+    EXPECT_EQ(scenario5DS::status, scenario5DS::expected_status);
+}
+
+TEST(SharedMemorySchedulerFailureTest, Scenario1) {
+    EXPECT_EQ(scenario6DS::status, scenario6DS::expected_status);
+    EXPECT_EQ(scenario6DS::thrown, scenario6DS::expected_thrown);
+    EXPECT_EQ(scenario6DS::reached, scenario6DS::expected_reached);
+    EXPECT_EQ(scenario6DS::ret(), scenario6DS::expected);
+    EXPECT_TRUE(scenario6DS::orphans_killed);
+    EXPECT_TRUE(scenario6DS::allChildrenReaped());
+}
+
 
 int main(int argc, char* argv[]) {
 
@@ -36,6 +66,137 @@ int main(int argc, char* argv[]) {
 
     scenario2DS::sch.joinAll();// end second Test Act
 
+    //third Test Act (UserCtrlSchedulerSyncPointTest)
+
+    scenario3DS::reached.push_back(scenario3DS::sch.runUntil(1, "after_push"));// 1
+    scenario3DS::sch.switchContextTo(1);// 11
+    scenario3DS::reached.push_back(scenario3DS::sch.runUntil(0, "before_push"));
+    scenario3DS::reached.push_back(scenario3DS::sch.runUntil(0, "after_push"));// 0
+    scenario3DS::winners.push_back(scenario3DS::sch.runUntilAny({2}, "after_push"));// 2
+    scenario3DS::sch.switchContextTo(2);// 12
+    scenario3DS::reached.push_back(scenario3DS::sch.runUntil(0, "after_push"));// 10
+    scenario3DS::winners.push_back(scenario3DS::sch.runUntilAny({0, 1, 2}, "after_push"));
+
+    scenario3DS::sch.joinAll();
+
+    {// the loser of the first runUntilAny is still armed on "A" and must be re-armed on "B"
+        auto winner = scenario3DS::sch_ab.runUntilAny({0, 1}, "A");
+        auto loser = 1 - winner;
+        auto index = scenario3DS::sch_ab.runUntilAny({loser}, "B");
+        scenario3DS::loser_passed_a.push_back(index == loser && scenario3DS::passed_a.size() == 1 && scenario3DS::passed_a[0] == int(loser));
+        scenario3DS::sch_ab.runUntil(winner, "B");
+        scenario3DS::sch_ab.switchContextTo(0, 1);
+    }
+
+    scenario3DS::sch_ab.joinAll();// end third Test Act
+
+    //fourth Test Act (UserCtrlSchedulerStateHashTest)
+
+    scenario4DS::sch_a.setStateHash([]{ return std::hash<int>{}(scenario4DS::counter_a); });
+    scenario4DS::sch_b.setStateHash([]{ return std::hash<int>{}(scenario4DS::counter_b); });
+
+    scenario4DS::sch_a.switchContextTo(0);
+    scenario4DS::visits.push_back(scenario4DS::sch_a.visitState(scenario4DS::visited));
+    scenario4DS::sch_a.switchContextTo(1);
+    scenario4DS::visits.push_back(scenario4DS::sch_a.visitState(scenario4DS::visited));
+
+    scenario4DS::sch_b.switchContextTo(1);
+    scenario4DS::visits.push_back(scenario4DS::sch_b.visitState(scenario4DS::visited));
+    scenario4DS::sch_b.switchContextTo(0);
+    scenario4DS::visits.push_back(scenario4DS::sch_b.visitState(scenario4DS::visited));
+
+    scenario4DS::sch_a.switchContextAll();
+    scenario4DS::sch_b.switchContextAll();
+    scenario4DS::sch_a.joinAll();
+    scenario4DS::sch_b.joinAll();
+
+    scenario4DS::sch_c.switchContextTo(0);
+    scenario4DS::site_visits.push_back(scenario4DS::sch_c.visitState(scenario4DS::visited_sites));
+    scenario4DS::sch_d.switchContextTo(0);
+    scenario4DS::site_visits.push_back(scenario4DS::sch_d.visitState(scenario4DS::visited_sites));
+    scenario4DS::sch_e.switchContextTo(0);
+    scenario4DS::site_visits.push_back(scenario4DS::sch_e.visitState(scenario4DS::visited_sites));
+    scenario4DS::sch_e.switchContextTo(0);
+    scenario4DS::site_visits.push_back(scenario4DS::sch_e.visitState(scenario4DS::visited_sites));
+
+    scenario4DS::sch_c.switchContextAll();
+    scenario4DS::sch_d.switchContextAll();
+    scenario4DS::sch_e.switchContextAll();
+    scenario4DS::sch_c.joinAll();
+    scenario4DS::sch_d.joinAll();
+    scenario4DS::sch_e.joinAll();// end fourth Test Act
+
+    //fifth Test Act (SharedMemorySchedulerTest), every thread has been joined so forking here is safe
+
+    {
+        auto sch = DeterministicConcurrency::make_SharedMemoryScheduler(
+            scenario5DS::process0, scenario5DS::process1, scenario5DS::process2);
+        sch.switchContextTo(2, 0, 1);// 4 0 2
+        sch.switchContextTo(0, 2);// 1 5
+        scenario5DS::status.push_back(sch.getThreadStatus(1));
+        scenario5DS::status.push_back(sch.getThreadStatus(0));
+        sch.switchContextTo(1);// 3
+        scenario5DS::status.push_back(sch.getThreadStatus(1));
+
+        sch.joinAll();
+    }// end fifth Test Act
+
+    //sixth Test Act (SharedMemorySchedulerFailureTest)
+
+    {// the exception of the child is reported once, by the switch during which it was thrown
+        auto sch = DeterministicConcurrency::make_SharedMemoryScheduler(std::tuple{&scenario6DS::throwingFunc});
+        sch.switchContextTo(0);
+        scenario6DS::thrown.push_back(false);
+        try { sch.switchContextTo(0); } catch (const std::exception&) { scenario6DS::thrown.back() = true; }
+        scenario6DS::status.push_back(sch.getThreadStatus(0));
+        sch.joinAll();
+    }
+
+    {
+        auto sch = DeterministicConcurrency::make_SharedMemoryScheduler(std::tuple{&scenario6DS::killedFunc});
+        sch.switchContextTo(0);
+        scenario6DS::thrown.push_back(false);
+        try { sch.switchContextTo(0); } catch (const std::exception&) { scenario6DS::thrown.back() = true; }
+        scenario6DS::status.push_back(sch.getThreadStatus(0));
+        sch.joinAll();
+    }
+
+    {// a child dying while running is seen by the polling APIs too
+        auto sch = DeterministicConcurrency::make_SharedMemoryScheduler(std::tuple{&scenario6DS::killedBeforeSyncPointFunc});
+        scenario6DS::thrown.push_back(false);
+        try { sch.runUntilAny({0}, "x"); } catch (const std::exception&) { scenario6DS::thrown.back() = true; }
+        scenario6DS::status.push_back(sch.getThreadStatus(0));
+        sch.joinAll();
+    }
+
+    scenario6DS::orphans_killed = scenario6DS::killParentOfScheduler();
+
+    {// destroyed before joinAll, the process is killed and reaped
+        auto sch = DeterministicConcurrency::make_SharedMemoryScheduler(std::tuple{&scenario6DS::neverJoinedFunc, 99});
+        sch.switchContextTo(0);
+    }
+
+    {
+        auto sch = DeterministicConcurrency::make_SharedMemoryScheduler(
+            std::tuple{&scenario6DS::lockingFunc, 0}, std::tuple{&scenario6DS::lockingFunc, 1});
+        sch.switchContextTo(0);
+        sch.proceed(1);
+        sch.waitUntilAllThreadStatus<DeterministicConcurrency::thread_status_t::WAITING_EXTERNAL>(1);
+        scenario6DS::status.push_back(sch.getThreadStatus(1));
+        sch.switchContextTo(0);
+        sch.waitUntilAllThreadStatus<DeterministicConcurrency::thread_status_t::WAITING>(1);
+        sch.switchContextTo(1);
+        sch.joinAll();
+    }
+
+    {
+        auto sch = DeterministicConcurrency::make_SharedMemoryScheduler(std::tuple{&scenario6DS::syncPointFunc, 2});
+        scenario6DS::reached.push_back(sch.runUntil(0, "before_push"));
+        scenario6DS::reached.push_back(sch.runUntil(0, "after_push"));
+        sch.switchContextTo(0);
+        sch.joinAll();
+    }// end sixth Test Act
+
     testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
 }